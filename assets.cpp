@@ -0,0 +1,129 @@
+#include "assets.h"
+#include <QWeakPointer>
+#include <cassert>
+#include <cstdlib>
+
+AssetStore::AssetStore() :
+    wallpaper(":/img/wallpaper.jpg"),
+    leftKey(":/img/left_key.png"),
+    rightKey(":/img/right_key.png"),
+    okIcon(":/img/ok.png"),
+    failIcon(":/img/fail.png") {
+    assert(!wallpaper.isNull());
+    assert(!leftKey.isNull());
+    assert(!rightKey.isNull());
+    assert(!okIcon.isNull());
+    assert(!failIcon.isNull());
+
+    shapes = generateShapes(SHAPE_SIZE);
+    for(int i = 0;i < shapes.size();i++) {
+        shapeImages.push_back(shapes[i].render());
+        shapeIcons.push_back(shapes[i].renderAsIcon(ICON_SIZE, ICON_SIZE));
+    }
+}
+
+QSharedPointer < const AssetStore > AssetStore::shared() {
+    // Only a weak reference is kept here, so the store is freed once the last Viewer is gone
+    static QWeakPointer < const AssetStore > instance;
+    QSharedPointer < const AssetStore > store = instance.toStrongRef();
+    if(!store) {
+        store = QSharedPointer < const AssetStore > (new AssetStore());
+        instance = store;
+    }
+    return store;
+}
+
+QVector < Shape > AssetStore::generateShapes(int size) {
+    QVector < Shape > shapes;
+    QVector < QPoint > triangle, circle, square, cross, plus, circumference, rhombus;
+    QVector < QColor > colors;
+    QVector < QString > colorNames;
+    int center = size / 2;
+    // Stroke and ring widths are tuned for SHAPE_SIZE and scale with the requested size
+    double stroke = 7.0 * size / SHAPE_SIZE;
+    double ring = 30.0 * size / SHAPE_SIZE;
+    for(int i = 0;i <= size;i++) {
+        for(int j = 0;j <= size;j++) {
+            QPoint point(i, j);
+            square.push_back(point);
+            if(abs(i - center) <= 0.7 * (size / 2 - abs(j - center))) {
+                rhombus.push_back(point);
+            }
+            qint64 distance = qint64(i - center) * (i - center) + qint64(j - center) * (j - center);
+            if(distance < qint64(center) * center) {
+                circle.push_back(point);
+                if(distance > qint64(center) * center - ring * ring) {
+                    circumference.push_back(point);
+                }
+            }
+            double delta = double(j) * center / size;
+            if(center - delta <= i && i <= center + delta) {
+                triangle.push_back(point);
+            }
+            if((j - stroke <= i && i <= j + stroke) || (j - stroke <= size - i && size - i <= j + stroke)) {
+                cross.push_back(point);
+            }
+            if((i - stroke <= center && center <= i + stroke) || (j - stroke <= center && center <= j + stroke)) {
+                plus.push_back(point);
+            }
+        }
+    }
+    colors.push_back(Qt::black);
+    colors.push_back(Qt::red);
+    colors.push_back(Qt::darkGreen);
+    colors.push_back(Qt::blue);
+    colors.push_back(Qt::yellow);
+    colors.push_back(Qt::magenta);
+    colors.push_back(Qt::cyan);
+    colors.push_back(QColor(0xFF, 0xA5, 0x00));
+    colorNames.push_back("Black");
+    colorNames.push_back("Red");
+    colorNames.push_back("Green");
+    colorNames.push_back("Blue");
+    colorNames.push_back("Yellow");
+    colorNames.push_back("Magenta");
+    colorNames.push_back("Cyan");
+    colorNames.push_back("Orange");
+    for(int i = 0;i < colors.size();i++) {
+        shapes.push_back(Shape(colors[i], triangle, colorNames[i], "triangle", size));
+        shapes.push_back(Shape(colors[i], square, colorNames[i], "square", size));
+        shapes.push_back(Shape(colors[i], circle, colorNames[i], "circle", size));
+        shapes.push_back(Shape(colors[i], cross, colorNames[i], "cross", size));
+        shapes.push_back(Shape(colors[i], plus, colorNames[i], "plus", size));
+        shapes.push_back(Shape(colors[i], circumference, colorNames[i], "circumference", size));
+        shapes.push_back(Shape(colors[i], rhombus, colorNames[i], "rhombus", size));
+    }
+    return shapes;
+}
+
+const QVector < Shape >& AssetStore::getShapes() const {
+    return shapes;
+}
+
+const QImage& AssetStore::getShapeImage(int i) const {
+    return shapeImages[i];
+}
+
+const QImage& AssetStore::getShapeIcon(int i) const {
+    return shapeIcons[i];
+}
+
+const QPixmap& AssetStore::getWallpaper() const {
+    return wallpaper;
+}
+
+const QImage& AssetStore::getLeftKey() const {
+    return leftKey;
+}
+
+const QImage& AssetStore::getRightKey() const {
+    return rightKey;
+}
+
+const QImage& AssetStore::getOkIcon() const {
+    return okIcon;
+}
+
+const QImage& AssetStore::getFailIcon() const {
+    return failIcon;
+}
@@ -0,0 +1,39 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "shape.h"
+
+// Decoded images, shape geometry and pre-rendered shapes shared by all Viewers of the process.
+// It is built on first use, never modified afterwards and released together with the last Viewer.
+class AssetStore {
+public:
+    enum { SHAPE_SIZE = 120, ICON_SIZE = 20 };
+
+    static QSharedPointer < const AssetStore > shared();
+    // Builds the full catalog of coloured shapes with the given side length
+    static QVector < Shape > generateShapes(int size);
+
+    const QVector < Shape >& getShapes() const;
+    const QImage& getShapeImage(int i) const;
+    const QImage& getShapeIcon(int i) const;
+    const QPixmap& getWallpaper() const;
+    const QImage& getLeftKey() const;
+    const QImage& getRightKey() const;
+    const QImage& getOkIcon() const;
+    const QImage& getFailIcon() const;
+
+private:
+    AssetStore();
+
+    QVector < Shape > shapes;
+    QVector < QImage > shapeImages, shapeIcons;
+    QPixmap wallpaper;
+    QImage leftKey, rightKey, okIcon, failIcon;
+};
+
+#endif // ASSETS_H
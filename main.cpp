@@ -1,10 +1,107 @@
 #include <QApplication>
+#include <QGuiApplication>
+#include <QScopedPointer>
+#include <QCommandLineParser>
+#include <QThread>
+#include <QVector>
+#include <QStringList>
+#include <QDebug>
 #include "widget.h"
+#include "metrics.h"
+#include "spritesheet.h"
+
+// Sprite export only renders into QImages, so it must work without a display
+static bool exportRequested(int argc, char *argv[]) {
+    for(int i = 1;i < argc;i++) {
+        QByteArray arg(argv[i]);
+        if(arg == "--export-sprites" || arg.startsWith("--export-sprites=")) {
+            return true;
+        }
+    }
+    return false;
+}
 
 int main(int argc, char *argv[]) {
-    QApplication a(argc, argv);
-    a.setApplicationName("Shapes Matching Game");
-    Widget w;
-    w.show();
-    return a.exec();
+    QScopedPointer < QCoreApplication > app;
+    if(exportRequested(argc, argv)) {
+        if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        app.reset(new QGuiApplication(argc, argv));
+    } else {
+        app.reset(new QApplication(argc, argv));
+    }
+    QCoreApplication::setApplicationName("Shapes Matching Game");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption metricsPort("metrics-port", "Serve Prometheus metrics on localhost:<port>.", "port");
+    QCommandLineOption metricsSocket("metrics-socket", "Serve Prometheus metrics on the Unix socket <path>.", "path");
+    QCommandLineOption windows("windows", "Open <count> independent game windows.", "count", "1");
+    QCommandLineOption exportSprites("export-sprites", "Export the shape catalog as sprite sheets into <dir> and exit.", "dir");
+    QCommandLineOption spriteSizes("sprite-sizes", "Comma-separated shape sizes for --export-sprites.", "sizes", "120");
+    parser.addOption(windows);
+    parser.addOption(exportSprites);
+    parser.addOption(spriteSizes);
+    parser.addOption(metricsPort);
+    parser.addOption(metricsSocket);
+    parser.process(*app);
+
+    if(parser.isSet(exportSprites)) {
+        QVector < int > sizes;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        QStringList values = parser.value(spriteSizes).split(',', Qt::SkipEmptyParts);
+#else
+        QStringList values = parser.value(spriteSizes).split(',', QString::SkipEmptyParts);
+#endif
+        for(int i = 0;i < values.size();i++) {
+            int size = values[i].trimmed().toInt();
+            if(size <= 0 || size > SpriteSheetExporter::MAX_SIZE) {
+                qWarning() << "Invalid sprite size" << values[i] << "- expected 1 to" << SpriteSheetExporter::MAX_SIZE;
+                return 1;
+            }
+            sizes.push_back(size);
+        }
+        return SpriteSheetExporter(parser.value(exportSprites), sizes).run() ? 0 : 1;
+    }
+
+    const int maxWindows = 16;
+    bool windowsOk = false;
+    int windowCount = parser.value(windows).toInt(&windowsOk);
+    if(!windowsOk || windowCount < 1 || windowCount > maxWindows) {
+        qWarning() << "Invalid window count" << parser.value(windows) << "- expected 1 to" << maxWindows;
+        return 1;
+    }
+
+    // The exporter lives in its own thread, so scrapes never wait for the GUI
+    QThread metricsThread;
+    if(parser.isSet(metricsPort) || parser.isSet(metricsSocket)) {
+        quint16 port = 0;
+        if(parser.isSet(metricsPort)) {
+            bool ok = false;
+            port = parser.value(metricsPort).toUShort(&ok);
+            if(!ok || port == 0) {
+                qWarning() << "Invalid metrics port" << parser.value(metricsPort);
+                return 1;
+            }
+        }
+        MetricsExporter *exporter = new MetricsExporter(port, parser.value(metricsSocket));
+        exporter->moveToThread(&metricsThread);
+        QObject::connect(&metricsThread, SIGNAL(started()), exporter, SLOT(listen()));
+        QObject::connect(&metricsThread, SIGNAL(finished()), exporter, SLOT(deleteLater()));
+        metricsThread.start();
+    }
+
+    // All windows share one AssetStore, each Viewer keeps only its own game state.
+    // A closed window is deleted right away, so its Viewer stops and drops its store reference.
+    for(int i = 0;i < windowCount;i++) {
+        Widget *widget = new Widget();
+        widget->setAttribute(Qt::WA_DeleteOnClose);
+        widget->show();
+    }
+    int result = app->exec();
+
+    metricsThread.quit();
+    metricsThread.wait();
+    return result;
 }
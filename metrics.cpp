@@ -0,0 +1,208 @@
+#include "metrics.h"
+#include <QtAlgorithms>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QHostAddress>
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+
+Histogram::Histogram() {
+    for(int i = 0;i < BUCKETS;i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+    sum.store(0, std::memory_order_relaxed);
+}
+
+int Histogram::bucketOf(quint64 micros) {
+    if(micros < SUB_COUNT) {
+        return micros;
+    }
+    int exponent = 63 - qCountLeadingZeroBits(micros);
+    int sub = (micros >> (exponent - SUB_BITS)) & (SUB_COUNT - 1);
+    return std::min(int(BUCKETS) - 1, (exponent - SUB_BITS + 1) * SUB_COUNT + sub);
+}
+
+quint64 Histogram::upperBound(int bucket) {
+    if(bucket < SUB_COUNT) {
+        return bucket;
+    }
+    int exponent = bucket / SUB_COUNT + SUB_BITS - 1;
+    quint64 width = quint64(1) << (exponent - SUB_BITS);
+    return (SUB_COUNT + bucket % SUB_COUNT) * width + width - 1;
+}
+
+void Histogram::record(qint64 micros) {
+    quint64 value = std::max(qint64(0), micros);
+    buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void Histogram::write(QTextStream &out, const QString &name, const QString &labels) const {
+    QString prefix = labels.isEmpty() ? QString() : labels + ",";
+    // All bounds but the overflow bucket are exported, so the set of series never changes between scrapes.
+    // Samples are truncated to whole microseconds, so a bucket ending at upperBound() holds samples below upperBound() + 1.
+    quint64 cumulative = 0;
+    for(int i = 0;i < BUCKETS - 1;i++) {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        out << name << "_bucket{" << prefix << "le=\"" << QString::number((upperBound(i) + 1) / 1e6, 'g', 10) << "\"} "
+            << cumulative << "\n";
+    }
+    cumulative += buckets[BUCKETS - 1].load(std::memory_order_relaxed);
+    out << name << "_bucket{" << prefix << "le=\"+Inf\"} " << cumulative << "\n";
+    QString braces = labels.isEmpty() ? QString() : "{" + labels + "}";
+    out << name << "_sum" << braces << " " << QString::number(sum.load(std::memory_order_relaxed) / 1e6, 'g', 15) << "\n";
+    out << name << "_count" << braces << " " << cumulative << "\n";
+}
+
+Metrics::Metrics() {
+    gamesCompleted.store(0, std::memory_order_relaxed);
+}
+
+Metrics& Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+void Metrics::recordPaint(PaintKind kind, qint64 micros) {
+    paintDuration[kind].record(micros);
+}
+
+void Metrics::recordTimerLateness(qint64 micros) {
+    timerLateness.record(micros);
+}
+
+void Metrics::recordKeyFeedback(qint64 micros) {
+    keyFeedbackLatency.record(micros);
+}
+
+void Metrics::recordScoreboardLoad(qint64 micros) {
+    scoreboardLoad.record(micros);
+}
+
+void Metrics::addGameCompleted() {
+    gamesCompleted.fetch_add(1, std::memory_order_relaxed);
+}
+
+QString Metrics::exposition() const {
+    static const char* frameNames[PAINT_KINDS] = { "menu", "play", "endgame", "help", "scores" };
+
+    QString result;
+    QTextStream out(&result);
+
+    out << "# HELP shapes_paint_duration_seconds Time spent painting one frame.\n";
+    out << "# TYPE shapes_paint_duration_seconds histogram\n";
+    for(int i = 0;i < PAINT_KINDS;i++) {
+        paintDuration[i].write(out, "shapes_paint_duration_seconds", QString("frame=\"%1\"").arg(frameNames[i]));
+    }
+
+    out << "# HELP shapes_timer_lateness_seconds Delay of the round timer past its interval.\n";
+    out << "# TYPE shapes_timer_lateness_seconds histogram\n";
+    timerLateness.write(out, "shapes_timer_lateness_seconds", QString());
+
+    out << "# HELP shapes_key_feedback_seconds Time from an answer key press to the painted feedback icon.\n";
+    out << "# TYPE shapes_key_feedback_seconds histogram\n";
+    keyFeedbackLatency.write(out, "shapes_key_feedback_seconds", QString());
+
+    out << "# HELP shapes_scoreboard_load_seconds Time spent reading scoreboard.txt.\n";
+    out << "# TYPE shapes_scoreboard_load_seconds histogram\n";
+    scoreboardLoad.write(out, "shapes_scoreboard_load_seconds", QString());
+
+    out << "# HELP shapes_games_completed_total Number of games played through the last round.\n";
+    out << "# TYPE shapes_games_completed_total counter\n";
+    out << "shapes_games_completed_total " << gamesCompleted.load(std::memory_order_relaxed) << "\n";
+
+    out.flush();
+    return result;
+}
+
+MetricsExporter::MetricsExporter(quint16 port, const QString &socketPath) :
+    port(port),
+    socketPath(socketPath),
+    tcpServer(nullptr),
+    localServer(nullptr) {}
+
+void MetricsExporter::listen() {
+    if(port != 0) {
+        tcpServer = new QTcpServer(this);
+        connect(tcpServer, SIGNAL(newConnection()), this, SLOT(acceptTcp()));
+        if(!tcpServer->listen(QHostAddress::LocalHost, port)) {
+            qWarning() << "Metrics: cannot listen on port" << port << ":" << tcpServer->errorString();
+        }
+    }
+    if(!socketPath.isEmpty()) {
+        localServer = new QLocalServer(this);
+        connect(localServer, SIGNAL(newConnection()), this, SLOT(acceptLocal()));
+        QLocalServer::removeServer(socketPath);
+        if(!localServer->listen(socketPath)) {
+            qWarning() << "Metrics: cannot listen on" << socketPath << ":" << localServer->errorString();
+        }
+    }
+}
+
+void MetricsExporter::acceptTcp() {
+    while(QTcpSocket *socket = tcpServer->nextPendingConnection()) {
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        watch(socket);
+    }
+}
+
+void MetricsExporter::acceptLocal() {
+    while(QLocalSocket *socket = localServer->nextPendingConnection()) {
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        watch(socket);
+    }
+}
+
+void MetricsExporter::watch(QIODevice *socket) {
+    connect(socket, SIGNAL(readyRead()), this, SLOT(respond()));
+    // Clients that never finish their request are dropped; the timer dies together with the socket
+    QTimer::singleShot(REQUEST_TIMEOUT, socket, [socket]() {
+        closeConnection(socket, true);
+    });
+}
+
+void MetricsExporter::closeConnection(QIODevice *socket, bool abort) {
+    if(QTcpSocket *tcp = qobject_cast < QTcpSocket* > (socket)) {
+        if(abort) {
+            tcp->abort();
+        } else {
+            tcp->disconnectFromHost();
+        }
+    } else if(QLocalSocket *local = qobject_cast < QLocalSocket* > (socket)) {
+        if(abort) {
+            local->abort();
+        } else {
+            local->disconnectFromServer();
+        }
+    }
+}
+
+void MetricsExporter::respond() {
+    QIODevice *socket = qobject_cast < QIODevice* > (sender());
+    if(!socket) {
+        return;
+    }
+
+    // Any request is answered with the metrics page once its headers are complete
+    QByteArray request = socket->property("request").toByteArray() + socket->readAll();
+    if(!request.contains("\r\n\r\n")) {
+        if(request.size() > MAX_REQUEST_SIZE) {
+            closeConnection(socket, true);
+        } else {
+            socket->setProperty("request", request);
+        }
+        return;
+    }
+    disconnect(socket, SIGNAL(readyRead()), this, SLOT(respond()));
+
+    QByteArray body = Metrics::instance().exposition().toUtf8();
+    socket->write("HTTP/1.0 200 OK\r\n"
+                  "Content-Type: text/plain; version=0.0.4\r\n"
+                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                  "Connection: close\r\n\r\n");
+    socket->write(body);
+    closeConnection(socket, false);
+}
@@ -0,0 +1,84 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QObject>
+#include <QString>
+#include <QTextStream>
+#include <atomic>
+
+class QTcpServer;
+class QLocalServer;
+
+// Log-linear histogram of microsecond samples: every power of two is split into SUB_COUNT equal buckets.
+// Recording is two relaxed atomic increments, so it is safe to call from the GUI thread
+// while the exporter thread reads the counters. Every bucket bound up to 2^EXPORT_BITS us is exported
+// on every scrape; slower samples land in a single overflow bucket that only shows up in +Inf.
+class Histogram {
+public:
+    enum { SUB_BITS = 2, SUB_COUNT = 1 << SUB_BITS, EXPORT_BITS = 26,
+           BUCKETS = (EXPORT_BITS - SUB_BITS + 1) * SUB_COUNT + 1 };
+
+    Histogram();
+    void record(qint64 micros);
+    void write(QTextStream& out, const QString& name, const QString& labels) const;
+
+private:
+    static int bucketOf(quint64 micros);
+    static quint64 upperBound(int bucket);
+
+    std::atomic < quint64 > buckets[BUCKETS];
+    std::atomic < quint64 > sum;
+};
+
+class Metrics {
+public:
+    enum PaintKind { PAINT_MENU, PAINT_PLAY, PAINT_ENDGAME, PAINT_HELP, PAINT_SCORES, PAINT_KINDS };
+
+    static Metrics& instance();
+
+    void recordPaint(PaintKind kind, qint64 micros);
+    void recordTimerLateness(qint64 micros);
+    void recordKeyFeedback(qint64 micros);
+    void recordScoreboardLoad(qint64 micros);
+    void addGameCompleted();
+
+    // Renders all metrics in the Prometheus text exposition format
+    QString exposition() const;
+
+private:
+    Metrics();
+
+    Histogram paintDuration[PAINT_KINDS];
+    Histogram timerLateness, keyFeedbackLatency, scoreboardLoad;
+    std::atomic < quint64 > gamesCompleted;
+};
+
+// Serves Metrics::exposition() over HTTP on a localhost port and/or a Unix socket.
+// Meant to be moved to its own QThread, so scrapes never touch the GUI event loop.
+class MetricsExporter : public QObject {
+    Q_OBJECT
+
+public:
+    enum { MAX_REQUEST_SIZE = 4096, REQUEST_TIMEOUT = 5000 };
+
+    MetricsExporter(quint16 port, const QString& socketPath);
+
+public slots:
+    void listen();
+
+private slots:
+    void acceptTcp();
+    void acceptLocal();
+    void respond();
+
+private:
+    void watch(QIODevice *socket);
+    static void closeConnection(QIODevice *socket, bool abort);
+
+    quint16 port;
+    QString socketPath;
+    QTcpServer *tcpServer;
+    QLocalServer *localServer;
+};
+
+#endif // METRICS_H
@@ -3,30 +3,45 @@
 Shape::Shape() {}
 
 Shape::Shape(const QColor &color, const QVector<QPoint> &points, const QString& colorName, const QString& shapeName,
-             int shiftX, int shiftY, int size):
-        color(color), points(points), colorName(colorName), shapeName(shapeName), shiftX(shiftX), shiftY(shiftY), size(size) {}
+             int size):
+        color(color), points(points), colorName(colorName), shapeName(shapeName), size(size) {}
 
 void Shape::draw(QPainter &p) const {
     p.setPen(QPen(color));
     p.setBrush(QBrush(color));
-    for(int i = 0;i < points.size();i++) {
-        p.drawPoint(points[i]);
-    }
+    p.drawPoints(points.constData(), points.size());
 }
 
 void Shape::drawAsIcon(QPainter &p, int x, int y, int w, int h) const {
     p.setPen(Qt::white);
     p.setBrush(QBrush(Qt::white));
+    QVector < QPointF > scaled;
+    scaled.reserve(points.size());
     for(int i = 0;i < points.size();i++) {
         QPointF cur = points[i];
-        cur.setX(cur.x() - shiftX);
-        cur.setY(cur.y() - shiftY);
         cur.setX(cur.x() / size * w);
         cur.setY(cur.y() / size * h);
         cur.setX(cur.x() + x);
         cur.setY(cur.y() + y);
-        p.drawPoint(cur);
+        scaled.push_back(cur);
     }
+    p.drawPoints(scaled.constData(), scaled.size());
+}
+
+QImage Shape::render() const {
+    QImage image(size + 1, size + 1, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter p(&image);
+    draw(p);
+    return image;
+}
+
+QImage Shape::renderAsIcon(int w, int h) const {
+    QImage image(w + 1, h + 1, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter p(&image);
+    drawAsIcon(p, 0, 0, w, h);
+    return image;
 }
 
 QString Shape::getColorName() const {
@@ -7,13 +7,15 @@ class Shape {
     QVector < QPoint > points;
     QString colorName, shapeName;
 
-    int shiftX, shiftY, size;
+    int size;
 public:
     Shape();
     Shape(const QColor& color, const QVector < QPoint > &points, const QString& colorName, const QString& shapeName,
-          int shiftX, int shiftY, int size);
+          int size);
     void draw(QPainter& p) const;
     void drawAsIcon(QPainter &p, int x, int y, int w, int h) const;
+    QImage render() const;
+    QImage renderAsIcon(int w, int h) const;
     QString getColorName() const;
     QString getShapeName() const;
     QColor getColor() const;
@@ -1,4 +1,4 @@
-QT += core gui widgets multimedia
+QT += core gui widgets multimedia network concurrent
 
 TARGET = shapes_matching_game
 TEMPLATE = app
@@ -6,11 +6,17 @@ TEMPLATE = app
 SOURCES += main.cpp \
            widget.cpp \
            viewer.cpp \
-           shape.cpp
+           shape.cpp \
+           metrics.cpp \
+           assets.cpp \
+           spritesheet.cpp
 
 HEADERS += widget.h \
            viewer.h \
-           shape.h
+           shape.h \
+           metrics.h \
+           assets.h \
+           spritesheet.h
 
 FORMS   += widget.ui \
            viewer.ui
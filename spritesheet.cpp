@@ -0,0 +1,154 @@
+#include "spritesheet.h"
+#include "assets.h"
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+#include <set>
+
+namespace {
+
+struct Sprite {
+    QString colorName, shapeName;
+    bool icon;
+    int x, y;
+};
+
+struct Sheet {
+    int size;
+    QString fileName;
+    QVector < Sprite > sprites;
+    bool allocated, saved;
+};
+
+// Generates the catalog for one size and paints it straight into the sheet:
+// one row per colour and a last row of white icons. Only the layout outlives the call.
+void exportSheet(Sheet& sheet, const QDir& dir) {
+    QVector < Shape > shapes = AssetStore::generateShapes(sheet.size);
+    std::set < QString > iconNames;
+    for(int i = 0;i < shapes.size();i++) {
+        iconNames.insert(shapes[i].getShapeName());
+    }
+    int cell = sheet.size + 1;
+    int columns = iconNames.size();
+    int count = shapes.size() + iconNames.size();
+    int rows = (count + columns - 1) / columns;
+
+    QImage image(columns * cell, rows * cell, QImage::Format_ARGB32_Premultiplied);
+    if(image.isNull()) {
+        return;
+    }
+    sheet.allocated = true;
+    image.fill(Qt::transparent);
+    QPainter p(&image);
+    for(int pass = 0;pass < 2;pass++) {
+        std::set < QString > drawnIcons;
+        for(int i = 0;i < shapes.size();i++) {
+            if(pass == 1 && !drawnIcons.insert(shapes[i].getShapeName()).second) {
+                continue;
+            }
+            Sprite sprite;
+            sprite.shapeName = shapes[i].getShapeName();
+            sprite.icon = (pass == 1);
+            if(!sprite.icon) {
+                sprite.colorName = shapes[i].getColorName();
+            }
+            sprite.x = (sheet.sprites.size() % columns) * cell;
+            sprite.y = (sheet.sprites.size() / columns) * cell;
+            if(sprite.icon) {
+                shapes[i].drawAsIcon(p, sprite.x, sprite.y, sheet.size, sheet.size);
+            } else {
+                p.save();
+                p.translate(sprite.x, sprite.y);
+                shapes[i].draw(p);
+                p.restore();
+            }
+            sheet.sprites.push_back(sprite);
+        }
+    }
+    p.end();
+    sheet.saved = image.save(dir.filePath(sheet.fileName), "PNG");
+}
+
+}
+
+SpriteSheetExporter::SpriteSheetExporter(const QString &directory, const QVector < int > &sizes) :
+    directory(directory),
+    sizes(sizes) {}
+
+bool SpriteSheetExporter::run() const {
+    QDir dir(directory);
+    if(!dir.mkpath(".")) {
+        qWarning() << "Cannot create" << directory;
+        return false;
+    }
+
+    // Each size gets exactly one sheet file, so repeated sizes are dropped
+    QVector < int > uniqueSizes = sizes;
+    std::sort(uniqueSizes.begin(), uniqueSizes.end());
+    uniqueSizes.erase(std::unique(uniqueSizes.begin(), uniqueSizes.end()), uniqueSizes.end());
+
+    QVector < Sheet > sheets;
+    for(int i = 0;i < uniqueSizes.size();i++) {
+        Sheet sheet;
+        sheet.size = uniqueSizes[i];
+        sheet.fileName = QString("shapes_%1.png").arg(uniqueSizes[i]);
+        sheet.allocated = sheet.saved = false;
+        sheets.push_back(sheet);
+    }
+
+    // One task per size generates the geometry, paints and encodes the sheet, then frees it,
+    // so memory is bounded by the sheets in flight rather than by all requested sizes
+    QtConcurrent::blockingMap(sheets, [&dir](Sheet& sheet) {
+        exportSheet(sheet, dir);
+    });
+
+    bool ok = true;
+    QJsonArray sheetsJson;
+    for(int i = 0;i < sheets.size();i++) {
+        if(!sheets[i].allocated) {
+            qWarning() << "Cannot allocate the sprite sheet for size" << sheets[i].size;
+            ok = false;
+        } else if(!sheets[i].saved) {
+            qWarning() << "Cannot write" << dir.filePath(sheets[i].fileName);
+            ok = false;
+        }
+        QJsonArray frames;
+        for(int j = 0;j < sheets[i].sprites.size();j++) {
+            const Sprite& sprite = sheets[i].sprites[j];
+            QJsonObject frame;
+            if(sprite.icon) {
+                frame["name"] = "icon_" + sprite.shapeName;
+            } else {
+                frame["name"] = sprite.colorName.toLower() + "_" + sprite.shapeName;
+                frame["color"] = sprite.colorName;
+            }
+            frame["shape"] = sprite.shapeName;
+            frame["x"] = sprite.x;
+            frame["y"] = sprite.y;
+            frame["w"] = sheets[i].size + 1;
+            frame["h"] = sheets[i].size + 1;
+            frames.append(frame);
+        }
+        QJsonObject sheetJson;
+        sheetJson["size"] = sheets[i].size;
+        sheetJson["image"] = sheets[i].fileName;
+        sheetJson["frames"] = frames;
+        sheetsJson.append(sheetJson);
+    }
+
+    QJsonObject index;
+    index["sheets"] = sheetsJson;
+    QFile file(dir.filePath("index.json"));
+    if(!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(index).toJson()) < 0) {
+        qWarning() << "Cannot write" << file.fileName();
+        return false;
+    }
+    return ok;
+}
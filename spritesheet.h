@@ -0,0 +1,24 @@
+#ifndef SPRITESHEET_H
+#define SPRITESHEET_H
+
+#include <QString>
+#include <QVector>
+
+// Renders the whole shape catalog (every shape/colour pair plus the white help-screen icons)
+// at the requested sizes, packs each size into one PNG sprite sheet and writes index.json next to them.
+// Every size is generated, painted and PNG-encoded as its own QtConcurrent task.
+class SpriteSheetExporter {
+public:
+    // Memory cap: a 2048 px sheet (7x9 cells of 2049 px) is about 1.06 GB per size being exported.
+    // The 2 GiB QImage limit itself is only reached at about 2900 px.
+    enum { MAX_SIZE = 2048 };
+
+    SpriteSheetExporter(const QString& directory, const QVector < int > &sizes);
+    bool run() const;
+
+private:
+    QString directory;
+    QVector < int > sizes;
+};
+
+#endif // SPRITESHEET_H
@@ -9,37 +9,34 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
-#include <ctime>
+#include <random>
 #include <cassert>
 #include <set>
 
 Viewer::Viewer(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::Viewer),
-    timer(this),
-    rnd(time(nullptr)) {
+    assets(AssetStore::shared()),
+    timer(this) {
     ui->setupUi(this);
 
+    // Windows and processes started in the same second must not replay the same rounds
+    rnd.seed(std::random_device()());
+
     QPalette pal = this->palette();
-    pal.setBrush(QPalette::Background, QBrush(QPixmap(":/img/wallpaper.jpg")));
+    pal.setBrush(QPalette::Background, QBrush(assets->getWallpaper()));
     this->setPalette(pal);
     this->setAutoFillBackground(true);
 
     this->setFocus();
 
-    connect(&timer, SIGNAL(timeout()), this, SLOT(update()));
+    connect(&timer, SIGNAL(timeout()), this, SLOT(tick()));
     timerInterval = 1000;
 
-    assert(leftKey.load(":/img/left_key.png"));
-    assert(rightKey.load(":/img/right_key.png"));
-    assert(okIcon.load(":/img/ok.png"));
-    assert(failIcon.load(":/img/fail.png"));
-
     okSound.setSource(QUrl("qrc:/sound/ok.wav"));
     failSound.setSource(QUrl("qrc:/sound/fail.wav"));
 
     totalRounds = 50;
-    ready = false;
     firstPlay = true;
     probGood = 0.5;
     probSameShape = probSameColor = probBad = 0.5 / 3;
@@ -63,34 +60,58 @@ void Viewer::play(bool newGame) {
         firstPlay = false;
         curFrame = PLAY;
         timer.start(timerInterval);
+        timerClock.start();
         curShape = score = round = 0;
         clicked = correct = okShown = false;
     } else if(!firstPlay) {
         curFrame = PLAY;
         timer.start(timerInterval);
+        timerClock.start();
+    }
+}
+
+void Viewer::tick() {
+    // The round timer only runs during a game, but keep paused screens out of the metric regardless
+    if(curFrame == PLAY && timerClock.isValid()) {
+        Metrics::instance().recordTimerLateness(timerClock.nsecsElapsed() / 1000 - timerInterval * 1000);
     }
+    timerClock.start();
+    update();
 }
 
 void Viewer::paintEvent(QPaintEvent *) {
+    QElapsedTimer paintClock;
+    paintClock.start();
+    FrameType frame = curFrame;
+    Metrics::PaintKind kind = Metrics::PAINT_KINDS;
     switch(curFrame) {
     case MENU:
         drawMenu();
+        kind = Metrics::PAINT_MENU;
         break;
     case PLAY:
         drawPlay();
+        kind = Metrics::PAINT_PLAY;
         break;
     case ENDGAME:
         drawEndGame();
+        kind = Metrics::PAINT_ENDGAME;
         break;
     case HELP:
         drawHelp();
+        kind = Metrics::PAINT_HELP;
         break;
     case SCORES:
         drawScores();
+        kind = Metrics::PAINT_SCORES;
         break;
     default:
         break;
     }
+    // After the last round drawPlay() only switches to ENDGAME without painting anything
+    if(kind != Metrics::PAINT_KINDS && curFrame == frame) {
+        Metrics::instance().recordPaint(kind, paintClock.nsecsElapsed() / 1000);
+    }
 }
 
 void Viewer::drawMenu() {
@@ -136,20 +157,18 @@ void Viewer::drawPlay() {
     if(round > totalRounds) {
         curFrame = ENDGAME;
         firstPlay = true;
+        timer.stop();
+        Metrics::instance().addGameCompleted();
 
-        QString playerName = QInputDialog::getText(this, "Game over", "Your name (for scoreboard):");
-        if (!playerName.isEmpty()) {
-            FILE* scoreboard = fopen("scoreboard.txt", "a");
-            assert(scoreboard);
-            fprintf(scoreboard, "%s\t%d\n", playerName.toStdString().c_str(), score);
-            fclose(scoreboard);
-        }
+        // The name prompt must not be opened from inside a paint event
+        QMetaObject::invokeMethod(this, "askPlayerName", Qt::QueuedConnection);
 
         update();
         return;
     }
 
     QPainter p(this);
+    const QVector < Shape >& shapes = assets->getShapes();
 
     // Draw frame
     p.setPen(QPen(Qt::white));
@@ -163,7 +182,8 @@ void Viewer::drawPlay() {
             curShape = boost::uniform_int<>(0, shapes.size() - 1)(rnd);
         }
     }
-    shapes[curShape].draw(p);
+    p.drawImage(this->width() / 2 - AssetStore::SHAPE_SIZE / 2, this->height() / 2 - AssetStore::SHAPE_SIZE / 2,
+                assets->getShapeImage(curShape));
 
     // Print text
     if(!clicked) {
@@ -188,12 +208,12 @@ void Viewer::drawPlay() {
                textBoxSize, textBoxSize, Qt::AlignCenter, text + " ?");
     shapeTextEquals = (text == shapes[curShape].getColorName() + " " + shapes[curShape].getShapeName());
 
-    QRect rect = leftKey.rect();
+    QRect rect = assets->getLeftKey().rect();
     rect.moveCenter(QPoint(this->width() / 3, this->height() - 35));
-    p.drawImage(rect.topLeft(), leftKey);
-    rect = rightKey.rect();
+    p.drawImage(rect.topLeft(), assets->getLeftKey());
+    rect = assets->getRightKey().rect();
     rect.moveCenter(QPoint(this->width() * 2 / 3, this->height() - 35));
-    p.drawImage(rect.topLeft(), rightKey);
+    p.drawImage(rect.topLeft(), assets->getRightKey());
     p.drawText(this->width() / 3 - textBoxSize / 2, this->height() - 70 - textBoxSize / 2,
                textBoxSize, textBoxSize, Qt::AlignCenter, "No");
     p.drawText(this->width() * 2 / 3 - textBoxSize / 2, this->height() - 70 - textBoxSize / 2,
@@ -206,18 +226,43 @@ void Viewer::drawPlay() {
 
     if(clicked) {
         if(correct) {
-            rect = okIcon.rect();
+            rect = assets->getOkIcon().rect();
             rect.moveCenter(QPoint(this->width() / 2, this->height() - 45));
-            p.drawImage(rect.topLeft(), okIcon);
+            p.drawImage(rect.topLeft(), assets->getOkIcon());
             okSound.play();
         } else {
-            rect = failIcon.rect();
+            rect = assets->getFailIcon().rect();
             rect.moveCenter(QPoint(this->width() / 2, this->height() - 45));
-            p.drawImage(rect.topLeft(), failIcon);
+            p.drawImage(rect.topLeft(), assets->getFailIcon());
             failSound.play();
         }
+        if(keyClock.isValid()) {
+            Metrics::instance().recordKeyFeedback(keyClock.nsecsElapsed() / 1000);
+            keyClock.invalidate();
+        }
         okShown = true;
         timer.start(timerInterval);
+        timerClock.start();
+    }
+}
+
+void Viewer::askPlayerName() {
+    // Window-modal, so the other game windows keep running while this player types
+    QInputDialog *dialog = new QInputDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowModality(Qt::WindowModal);
+    dialog->setWindowTitle("Game over");
+    dialog->setLabelText("Your name (for scoreboard):");
+    connect(dialog, SIGNAL(textValueSelected(QString)), this, SLOT(saveScore(QString)));
+    dialog->open();
+}
+
+void Viewer::saveScore(const QString &playerName) {
+    if (!playerName.isEmpty()) {
+        FILE* scoreboard = fopen("scoreboard.txt", "a");
+        assert(scoreboard);
+        fprintf(scoreboard, "%s\t%d\n", playerName.toStdString().c_str(), score);
+        fclose(scoreboard);
     }
 }
 
@@ -274,21 +319,23 @@ void Viewer::drawHelp() {
                + "your score wouldn't change. You can pause the game and open the menu by pressing ESC at any time.");
 
     // Draw shapes
-    std::map < QString, Shape > shapeNames;
+    const QVector < Shape >& shapes = assets->getShapes();
+    std::map < QString, int > shapeNames;
     for(int i = 0;i < shapes.size();i++) {
         QString name = shapes[i].getShapeName();
         name[0] = name[0].toUpper();
-        shapeNames.insert(std::make_pair(name, shapes[i]));
+        shapeNames.insert(std::make_pair(name, i));
     }
     font.setPointSize(12);
     p.setFont(font);
     p.setBrush(QBrush(Qt::white));
     int gap = this->width() / shapeNames.size();
     int cnt = 0;
-    for(std::map < QString, Shape > :: iterator it = shapeNames.begin();it != shapeNames.end();++it) {
+    for(std::map < QString, int > :: iterator it = shapeNames.begin();it != shapeNames.end();++it) {
         p.drawText(cnt * gap + 40 - textBoxSize / 2, this->height() - 200 - textBoxSize / 2,
                    textBoxSize, textBoxSize, Qt::AlignCenter, it->first);
-        it->second.drawAsIcon(p, cnt * gap + 40 - 20 / 2, this->height() - 170 - 20 / 2, 20, 20);
+        p.drawImage(cnt * gap + 40 - AssetStore::ICON_SIZE / 2, this->height() - 170 - AssetStore::ICON_SIZE / 2,
+                    assets->getShapeIcon(it->second));
         cnt++;
     }
 
@@ -335,6 +382,8 @@ void Viewer::drawScores() {
                textBoxSize, textBoxSize, Qt::AlignCenter, "Scoreboard");
 
     // Get scores
+    QElapsedTimer loadClock;
+    loadClock.start();
     QVector < std::pair < int, QString > > data;
     FILE* scoreboard = fopen("scoreboard.txt", "r");
     if(scoreboard) {
@@ -347,6 +396,7 @@ void Viewer::drawScores() {
         fclose(scoreboard);
     }
     std::sort(data.begin(), data.end(), std::greater < std::pair < int, QString > > ());
+    Metrics::instance().recordScoreboardLoad(loadClock.nsecsElapsed() / 1000);
 
     // Draw scoreboard
     for(int i = 0;i < std::min(8, data.size());i++) {
@@ -397,6 +447,7 @@ void Viewer::keyPressEvent(QKeyEvent *event) {
 void Viewer::keyPlay(QKeyEvent *event) {
     if(event->key() == Qt::Key_Escape) {
         curFrame = MENU;
+        timer.stop();
         update();
         return;
     }
@@ -412,6 +463,7 @@ void Viewer::keyPlay(QKeyEvent *event) {
     }
     score = std::max(0, score + correct * 2 - 1);
     clicked = true;
+    keyClock.start();
     update();
 }
 
@@ -466,67 +518,3 @@ void Viewer::keyScores(QKeyEvent *event) {
     }
     update();
 }
-
-void Viewer::resizeEvent(QResizeEvent *) {
-    if(!ready) {
-        ready = true;
-
-        QVector < QPoint > triangle, circle, square, cross, plus, circumference, rhombus;
-        QVector < QColor > colors;
-        QVector < QString > colorNames;
-        int size = 120;
-        int center = size / 2;
-        int shiftX = this->width() / 2 - center;
-        int shiftY = this->height() / 2 - center;
-        for(int i = 0;i <= size;i++) {
-            for(int j = 0;j <= size;j++) {
-                QPoint point(shiftX + i, shiftY + j);
-                square.push_back(point);
-                if(abs(i - center) <= 0.7 * (size / 2 - abs(j - center))) {
-                    rhombus.push_back(point);
-                }
-                if((i - center) * (i - center) + (j - center) * (j - center) < center * center) {
-                    circle.push_back(point);
-                    if((i - center) * (i - center) + (j - center) * (j - center) > center * center - 30 * 30) {
-                        circumference.push_back(point);
-                    }
-                }
-                double delta = double(j) * center / size;
-                if(center - delta <= i && i <= center + delta) {
-                    triangle.push_back(point);
-                }
-                if((j - 7 <= i && i <= j + 7) || (j - 7 <= size - i && size - i <= j + 7)) {
-                    cross.push_back(point);
-                }
-                if((i - 7 <= center && center <= i + 7) || (j - 7 <= center && center <= j + 7)) {
-                    plus.push_back(point);
-                }
-            }
-        }
-        colors.push_back(Qt::black);
-        colors.push_back(Qt::red);
-        colors.push_back(Qt::darkGreen);
-        colors.push_back(Qt::blue);
-        colors.push_back(Qt::yellow);
-        colors.push_back(Qt::magenta);
-        colors.push_back(Qt::cyan);
-        colors.push_back(QColor(0xFF, 0xA5, 0x00));
-        colorNames.push_back("Black");
-        colorNames.push_back("Red");
-        colorNames.push_back("Green");
-        colorNames.push_back("Blue");
-        colorNames.push_back("Yellow");
-        colorNames.push_back("Magenta");
-        colorNames.push_back("Cyan");
-        colorNames.push_back("Orange");
-        for(int i = 0;i < colors.size();i++) {
-            shapes.push_back(Shape(colors[i], triangle, colorNames[i], "triangle", shiftX, shiftY, size));
-            shapes.push_back(Shape(colors[i], square, colorNames[i], "square", shiftX, shiftY, size));
-            shapes.push_back(Shape(colors[i], circle, colorNames[i], "circle", shiftX, shiftY, size));
-            shapes.push_back(Shape(colors[i], cross, colorNames[i], "cross", shiftX, shiftY, size));
-            shapes.push_back(Shape(colors[i], plus, colorNames[i], "plus", shiftX, shiftY, size));
-            shapes.push_back(Shape(colors[i], circumference, colorNames[i], "circumference", shiftX, shiftY, size));
-            shapes.push_back(Shape(colors[i], rhombus, colorNames[i], "rhombus", shiftX, shiftY, size));
-        }
-    }
-}
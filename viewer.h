@@ -6,12 +6,15 @@
 #include <QPainter>
 #include <QSoundEffect>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <map>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int.hpp>
 
 #include "shape.h"
+#include "assets.h"
 #include "widget.h"
+#include "metrics.h"
 
 namespace Ui {
 class Viewer;
@@ -24,10 +27,14 @@ public:
     explicit Viewer(QWidget *parent);
     ~Viewer();
 
+private slots:
+    void tick();
+    void askPlayerName();
+    void saveScore(const QString& playerName);
+
 private:
     Ui::Viewer *ui;
     void paintEvent(QPaintEvent *);
-    void resizeEvent(QResizeEvent *);
     void keyPressEvent(QKeyEvent *);
 
     void drawMenu();
@@ -46,13 +53,13 @@ private:
 
     enum FrameType { PLAY, RESUME, SCORES, HELP, EXIT, MENU, ENDGAME };
 
-    QVector < Shape > shapes;
+    QSharedPointer < const AssetStore > assets;
     QTimer timer;
+    QElapsedTimer timerClock, keyClock;
     QString text;
     int curShape, score, totalRounds, round, timerInterval;
-    bool ready, shapeTextEquals, clicked, correct, okShown, firstPlay;
+    bool shapeTextEquals, clicked, correct, okShown, firstPlay;
     double probGood, probSameShape, probSameColor, probBad;
-    QImage leftKey, rightKey, okIcon, failIcon;
     boost::mt19937 rnd;
     FrameType curFrame, curMenuPos;
     QVector < QString > buttons;